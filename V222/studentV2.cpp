@@ -192,13 +192,16 @@ public:
         std::cout << "\n==============================================================================\n" << std::endl;
     }
 
-    std::vector<Student> getAllStudents() {
-        std::vector<Student> students;
+    // Pointers into the table, so callers can sort and scan without copying
+    // the records. They stay valid until the next add or delete.
+    std::vector<const Student*> getAllStudents() const {
+        std::vector<const Student*> students;
+        students.reserve(elementCount);
         
         for (int i = 0; i < TABLE_SIZE; i++) {
-            Node* current = table[i];
+            const Node* current = table[i];
             while (current != nullptr) {
-                students.push_back(current->data);
+                students.push_back(&current->data);
                 current = current->next;
             }
         }
@@ -215,13 +218,13 @@ public:
         }
 
         std::sort(students.begin(), students.end(), 
-            [](const Student& a, const Student& b) {
-                return a.gpa > b.gpa;
+            [](const Student* a, const Student* b) {
+                return a->gpa > b->gpa;
             });
         
         std::cout << "\n======================== STUDENTS SORTED BY GPA (DESCENDING) ========================\n";
-        for (const auto& student : students) {
-            displayStudentInfo(student);
+        for (const Student* student : students) {
+            displayStudentInfo(*student);
         }
     }
 
@@ -234,13 +237,13 @@ public:
         }
 
         std::sort(students.begin(), students.end(),
-            [](const Student& a, const Student& b) {
-                return a.studentName < b.studentName;
+            [](const Student* a, const Student* b) {
+                return a->studentName < b->studentName;
             });
         
         std::cout << "\n======================== STUDENTS SORTED BY NAME (ASCENDING) ========================\n";
-        for (const auto& student : students) {
-            displayStudentInfo(student);
+        for (const Student* student : students) {
+            displayStudentInfo(*student);
         }
     }
 
@@ -339,12 +342,12 @@ public:
         std::map<int, int> levelCounts;
         std::map<int, double> levelGpaSums;
 
-        for (const auto& student : students) {
-            totalGPA += student.gpa;
-            deptCounts[student.department]++;
-            deptGpaSums[student.department] += student.gpa;
-            levelCounts[student.level]++;
-            levelGpaSums[student.level] += student.gpa;
+        for (const Student* student : students) {
+            totalGPA += student->gpa;
+            deptCounts[student->department]++;
+            deptGpaSums[student->department] += student->gpa;
+            levelCounts[student->level]++;
+            levelGpaSums[student->level] += student->gpa;
         }
 
         std::cout << "Overall Average GPA: " << std::fixed << std::setprecision(2)